@@ -0,0 +1,142 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "evaluator.hpp"
+#include "parser.hpp"
+
+// Scores a .part file against the netlist it was made for:
+//   FMEval <aux file> <part file> [area|num <cap>] [--scalar]
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    EvalKernel kernel = EvalKernel::Auto;
+    for (auto it = args.begin(); it != args.end();) {
+        if (*it == "--scalar") {
+            kernel = EvalKernel::Scalar;
+            it = args.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (args.size() != 2 && args.size() != 4) {
+        std::cerr << "Usage: FMEval <aux file> <part file> [area|num <cap>] [--scalar]" << std::endl;
+        return 1;
+    }
+    if (args.size() == 4 && args[2] != "area" && args[2] != "num") {
+        std::cerr << "Invalid area definition. Use 'num' or 'area'." << std::endl;
+        return 1;
+    }
+    int64_t cap = 0;
+    if (args.size() == 4) {
+        try {
+            size_t used = 0;
+            cap = std::stoll(args[3], &used);
+            if (used != args[3].size()) throw std::invalid_argument(args[3]);
+        } catch (const std::exception&) {
+            std::cerr << "Invalid cap. Use a whole number." << std::endl;
+            return 1;
+        }
+    }
+
+    Parser parser;
+    HypergraphBuilder builder;
+    std::vector<std::string> nodeNames;
+    if (!parser.loadHypergraph(args[0], builder, nodeNames)) {
+        std::cerr << "Failed to load input files." << std::endl;
+        return 1;
+    }
+    Hypergraph graph = builder.build();
+
+    std::unordered_map<std::string, int> nodeIds;
+    for (int v = 0; v < graph.numNodes(); v++) {
+        nodeIds[nodeNames[graph.originalId(v)]] = v;
+    }
+
+    std::ifstream partFile(args[1]);
+    if (!partFile.is_open()) {
+        std::cerr << "Could not open partition file." << std::endl;
+        return 1;
+    }
+
+    // Read "Partition A:" / "Partition B:" sections of node names
+    std::vector<uint8_t> side(graph.numNodes(), 0);
+    std::vector<uint8_t> seen(graph.numNodes(), 0);
+    int current = -1;
+    int unknown = 0, duplicates = 0;
+    std::string line;
+    while (std::getline(partFile, line)) {
+        std::istringstream iss(line);
+        std::string word;
+        if (!(iss >> word)) continue;
+
+        if (word == "Partition") {
+            std::string label;
+            iss >> label;
+            current = (label == "A:") ? 0 : (label == "B:") ? 1 : -1;
+            continue;
+        }
+        if (current < 0) {
+            std::cerr << "Unexpected line in partition file: " << line << std::endl;
+            return 1;
+        }
+
+        auto it = nodeIds.find(word);
+        if (it == nodeIds.end()) {
+            unknown++;
+            continue;
+        }
+        if (seen[it->second]) duplicates++;
+        seen[it->second] = 1;
+        side[it->second] = static_cast<uint8_t>(current);
+    }
+
+    int missing = 0;
+    for (uint8_t s : seen) {
+        if (!s) missing++;
+    }
+
+    std::vector<uint64_t> sideBits;
+    packSides(side, sideBits);
+    Evaluator evaluator(graph, kernel);
+
+    auto start = std::chrono::steady_clock::now();
+    EvalResult eval = evaluator.evaluate(sideBits);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Nodes: " << graph.numNodes() << "  Nets: " << graph.numNets()
+              << "  Pins: " << graph.numPins() << std::endl;
+    std::cout << "Cut size: " << eval.cutSize << " (" << eval.cutNets << " nets)" << std::endl;
+    std::cout << "km1: " << eval.km1 << std::endl;
+    std::cout << "Partition A: " << eval.count[0] << " nodes, area " << eval.area[0] << std::endl;
+    std::cout << "Partition B: " << eval.count[1] << " nodes, area " << eval.area[1] << std::endl;
+    std::cout << "Evaluated in " << ms << " ms ("
+              << (evaluator.getKernel() == EvalKernel::Avx2 ? "avx2" : "scalar") << ")" << std::endl;
+
+    bool valid = true;
+    if (missing > 0) {
+        std::cout << "Unassigned nodes: " << missing << std::endl;
+        valid = false;
+    }
+    if (duplicates > 0) {
+        std::cout << "Nodes listed more than once: " << duplicates << std::endl;
+        valid = false;
+    }
+    if (unknown > 0) {
+        std::cout << "Names not in the netlist (or terminals): " << unknown << std::endl;
+    }
+
+    if (args.size() == 4) {
+        int64_t loadA = args[2] == "area" ? eval.area[0] : eval.count[0];
+        int64_t loadB = args[2] == "area" ? eval.area[1] : eval.count[1];
+        bool withinCap = loadA <= cap && loadB <= cap;
+        std::cout << "Cap " << cap << " (" << args[2] << "): " << (withinCap ? "met" : "exceeded") << std::endl;
+        valid = valid && withinCap;
+    }
+
+    return valid ? 0 : 2;
+}
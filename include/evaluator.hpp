@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "hypergraph.hpp"
+
+// Packs a per-node side vector (0 = A, 1 = B) into 64-bit words, node v at
+// bit v % 64 of word v / 64. Reuses the storage already in bits.
+void packSides(const std::vector<uint8_t>& side, std::vector<uint64_t>& bits);
+
+struct EvalResult {
+    int64_t cutSize = 0;  // weighted nets with pins on both sides
+    int64_t km1 = 0;      // sum of weight * (connectivity - 1)
+    int cutNets = 0;      // nets with pins on both sides, unweighted
+    int64_t area[2] = {0, 0};
+    int count[2] = {0, 0};
+};
+
+enum class EvalKernel { Auto, Scalar, Avx2 };
+
+// Scores a bit-packed partition against a Hypergraph, independently of any
+// FM bookkeeping. One streaming pass over the pin array looks up the side of
+// every pin (with AVX2 gathers when the CPU has them), then each net is
+// classified with a popcount over its run of pin bits. A Compressed graph
+// has no pin array, so its nets are decoded one at a time instead.
+class Evaluator {
+   public:
+    // Auto picks AVX2 when the running CPU supports it; asking for Avx2 on a
+    // CPU without it falls back to the scalar kernel as well
+    explicit Evaluator(const Hypergraph& graph, EvalKernel kernel = EvalKernel::Auto);
+
+    // sideBits as filled by packSides; throws std::invalid_argument when it
+    // holds fewer words than the graph has nodes
+    EvalResult evaluate(const std::vector<uint64_t>& sideBits);
+
+    EvalKernel getKernel() const { return kernel; }
+    static bool avx2Supported();
+
+   private:
+    const Hypergraph& graph;
+    EvalKernel kernel;
+    std::vector<uint64_t> pinBits;  // side of every pin, in pin array order
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Read-only view over a contiguous run of IDs (the pins of a net or the nets of a node)
+struct IdRange {
+    const int* first;
+    const int* last;
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    int size() const { return static_cast<int>(last - first); }
+};
+
+// Csr keeps plain int arrays. Compressed stores every pin list as sorted IDs,
+// delta encoded into LEB128 varints, after renumbering the nodes in the order
+// the nets first touch them so that the deltas stay small.
+enum class StorageMode { Csr, Compressed };
+
+// Hypergraph stored as two adjacency lists: net -> pins and node -> nets.
+// Nodes and nets are identified by dense IDs starting at 0. Nets keep the
+// order they were added in; nodes do too in Csr mode. Whenever nodes get
+// renumbered (Compressed mode, permute()), originalId() maps a node back to
+// the ID the HypergraphBuilder handed out.
+class Hypergraph {
+   public:
+    int numNodes() const { return static_cast<int>(nodeWeights.size()); }
+    int numNets() const { return static_cast<int>(netWeights.size()); }
+    int numPins() const { return pinCount; }
+
+    StorageMode getStorageMode() const { return mode; }
+    int originalId(int node) const { return originalIds.empty() ? node : originalIds[node]; }
+
+    int64_t nodeWeight(int node) const { return nodeWeights[node]; }
+    int netWeight(int net) const { return netWeights[net]; }
+
+    // Calls f(node) for every pin of net / f(net) for every net of node, in
+    // increasing ID order. Works in both storage modes.
+    template <typename F>
+    void forEachPin(int net, F&& f) const {
+        if (mode == StorageMode::Csr) {
+            for (int v : netPins(net)) f(v);
+        } else {
+            decode(pinBytes.data() + netByteOffsets[net], pinBytes.data() + netByteOffsets[net + 1], f);
+        }
+    }
+    template <typename F>
+    void forEachNet(int node, F&& f) const {
+        if (mode == StorageMode::Csr) {
+            for (int e : nodeNets(node)) f(e);
+        } else {
+            decode(netBytes.data() + nodeByteOffsets[node], netBytes.data() + nodeByteOffsets[node + 1], f);
+        }
+    }
+
+    // First pin of net for which pred(node) holds, or -1. Stops scanning at the match.
+    template <typename Pred>
+    int findPin(int net, Pred&& pred) const {
+        if (mode == StorageMode::Csr) {
+            for (int v : netPins(net)) {
+                if (pred(v)) return v;
+            }
+            return -1;
+        }
+        int found = -1;
+        decode(pinBytes.data() + netByteOffsets[net], pinBytes.data() + netByteOffsets[net + 1], [&](int v) {
+            if (pred(v)) found = v;
+            return found >= 0;
+        });
+        return found;
+    }
+
+    // Direct access to the CSR arrays, only valid in Csr mode.
+    // The pins of net e are [netOffset(e), netOffset(e + 1)) of pinData().
+    IdRange netPins(int net) const {
+        return {pins.data() + netOffsets[net], pins.data() + netOffsets[net + 1]};
+    }
+    IdRange nodeNets(int node) const {
+        return {nodeNetList.data() + nodeOffsets[node], nodeNetList.data() + nodeOffsets[node + 1]};
+    }
+    const int* pinData() const { return pins.data(); }
+    int netOffset(int net) const { return netOffsets[net]; }
+
+    // Largest sum of net weights over the nets of a single node, which bounds
+    // any FM gain. Net weights are at most INT_MAX, so this fits in 64 bits.
+    int64_t maxWeightedDegree() const { return maxDegree; }
+
+    // Bytes held by the adjacency lists and their offsets (weights excluded)
+    size_t storageBytes() const;
+
+    // Renumbers in place so that node nodeOrder[i] becomes node i and net
+    // netOrder[j] becomes net j. Both must be full permutations; originalId()
+    // keeps giving the builder IDs. The node -> nets index is dropped before
+    // the net -> pins lists are rewritten, so no second graph is ever built.
+    void permute(const std::vector<int>& nodeOrder, const std::vector<int>& netOrder);
+
+   private:
+    friend class HypergraphBuilder;
+
+    // Builds node -> nets from net -> pins and recomputes maxDegree
+    void buildNodeIndex();
+
+    // Calls f(id) for each encoded ID; a callback returning true stops the decode
+    template <typename F>
+    static void decode(const uint8_t* p, const uint8_t* end, F&& f) {
+        int id = 0;
+        while (p < end) {
+            uint32_t delta = *p & 0x7f;
+            for (int shift = 7; *p++ & 0x80; shift += 7) {
+                delta |= static_cast<uint32_t>(*p & 0x7f) << shift;
+            }
+            id += static_cast<int>(delta);
+            if constexpr (std::is_same_v<decltype(f(id)), bool>) {
+                if (f(id)) return;
+            } else {
+                f(id);
+            }
+        }
+    }
+
+    StorageMode mode = StorageMode::Csr;
+    int pinCount = 0;
+    int64_t maxDegree = 0;
+
+    std::vector<int64_t> nodeWeights;
+    std::vector<int> netWeights;
+    std::vector<int> originalIds;  // empty when node IDs were kept
+
+    // Csr
+    std::vector<int> netOffsets;  // numNets + 1 entries into pins
+    std::vector<int> pins;
+    std::vector<int> nodeOffsets;  // numNodes + 1 entries into nodeNetList
+    std::vector<int> nodeNetList;
+
+    // Compressed
+    std::vector<uint32_t> netByteOffsets;  // numNets + 1 entries into pinBytes
+    std::vector<uint8_t> pinBytes;
+    std::vector<uint32_t> nodeByteOffsets;  // numNodes + 1 entries into netBytes
+    std::vector<uint8_t> netBytes;
+};
+
+// Collects nodes and nets and turns them into a Hypergraph.
+//
+//   HypergraphBuilder builder;
+//   int a = builder.addNode(4), b = builder.addNode(6);
+//   builder.addNet({a, b});
+//   Hypergraph graph = builder.build();
+//
+// In Compressed mode each net is encoded as soon as it is added, so the
+// uncompressed pin list never exists in memory.
+class HypergraphBuilder {
+   public:
+    explicit HypergraphBuilder(StorageMode mode = StorageMode::Csr);
+
+    void reserve(int nodes, int nets, int pins);
+
+    // Returns the ID of the new node / net. Pin IDs must name nodes that were
+    // already added; a node listed twice in the same net is only kept once.
+    // Net weights run from 1 to INT_MAX and are summed in 64 bits.
+    int addNode(int64_t weight = 1);
+    int addNet(const std::vector<int>& pins, int weight = 1);
+    int addNet(const int* pins, int count, int weight = 1);
+
+    int numNodes() const { return static_cast<int>(graph.nodeWeights.size()); }
+    int numNets() const { return static_cast<int>(graph.netWeights.size()); }
+
+    // Builds the node -> nets index and hands over the graph. The builder is
+    // empty afterwards and can be reused.
+    Hypergraph build();
+
+   private:
+    StorageMode mode;
+    Hypergraph graph;
+
+    // Compressed mode: first-touch renumbering and a scratch list for encoding
+    std::vector<int> newIds;
+    int nextId = 0;
+    std::vector<int> scratch;
+
+    void buildCsr();
+    void buildCompressed();
+};
@@ -1,23 +1,36 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "hypergraph.hpp"
 #include "net.hpp"
 #include "node.hpp"
 
 class Parser {
    public:
+    // Loads the netlist into the name-keyed nodes / nets maps. The tools use
+    // loadHypergraph instead; this stays for printSummary / printNets and for
+    // code that wants to look nodes and nets up by name.
     bool loadAuxFile(const std::string& path);
     void printSummary() const;
     void printNets() const;
     const std::unordered_map<std::string, Node>& getNodes() const;
     const std::unordered_map<std::string, Net>& getNets() const;
 
+    // Streams the netlist into builder without keeping any of it as strings.
+    // Terminals are left out together with their pins, and nodes get builder
+    // IDs in .nodes file order. If a name appears more than once in .nodes,
+    // the first line wins. nodeNames[id] receives the name of each node.
+    bool loadHypergraph(const std::string& auxPath, HypergraphBuilder& builder,
+                        std::vector<std::string>& nodeNames);
+
    private:
-    bool loadNodesFile(const std::string& path);
-    bool loadNetsFile(const std::string& path);
+    bool readAuxFile(const std::string& path);
+    bool loadNodesFile(const std::string& path, const std::function<void(Node&)>& onNode);
+    bool loadNetsFile(const std::string& path, const std::function<void(Net&)>& onNet);
 
     std::string nodesFilePath;
     std::string netsFilePath;
@@ -1,59 +1,96 @@
 #pragma once
 
-#include <algorithm>
-#include <cstdlib>
-#include <ctime>
+#include <cstdint>
 #include <iostream>
 #include <map>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
-#include "net.hpp"
-#include "node.hpp"
+#include "evaluator.hpp"
+#include "hypergraph.hpp"
 
 enum class AreaDef { Area, Num };
 
+struct PartitionResult {
+    std::vector<uint8_t> side;  // per builder node ID: 0 = partition A, 1 = partition B
+
+    int64_t cutSize = 0;  // sum of the weights of nets with pins in both partitions
+    int64_t km1 = 0;
+    int64_t areaA = 0;
+    int64_t areaB = 0;
+    int countA = 0;
+    int countB = 0;
+    int passes = 0;  // FM passes that improved the cut
+    bool feasible = false;
+};
+
+// Two-way Fiduccia-Mattheyses partitioner over a Hypergraph.
+//
+// All working buffers are sized for the graph once, in the constructor.
+// reset() starts over with a new cap / area definition and run() improves the
+// current partition, so the same object can be rerun without reallocating.
 class Partitioner {
    public:
-    Partitioner(const std::unordered_map<std::string, Node>& nodes,
-                const std::unordered_map<std::string, Net>& nets,
-                AreaDef areaDef,
-                int cap);
+    explicit Partitioner(const Hypergraph& graph);
+    Partitioner(const Hypergraph& graph, AreaDef areaDef, int64_t cap);
+
+    // Builds the initial greedy partition for the given constraints
+    void reset(int64_t cap, AreaDef areaDef);
 
-    void runFM();
-    void printResult() const;
-    void printResult(std::ostream& os) const;
+    // Runs FM passes until the cut stops improving. When the initial partition
+    // is infeasible the result is returned untouched with feasible == false.
+    const PartitionResult& run();
 
+    const PartitionResult& getResult() const;
     bool isPartitionFeasible() const;
 
+    // Writes the partition in the .part format, nodeNames[id] naming builder node id
+    void printResult(std::ostream& os, const std::vector<std::string>& nodeNames) const;
+
    private:
-    const std::unordered_map<std::string, Node>& nodes;
-    const std::unordered_map<std::string, Net>& nets;
-    AreaDef areaDef;  // Area or Num
+    const Hypergraph& graph;
+    AreaDef areaDef = AreaDef::Area;
+    int64_t cap = 0;
 
-    std::unordered_map<std::string, std::string> nodeToPartition;  // "A" or "B"
-    std::unordered_map<std::string, std::vector<std::string>> nodeToNets;
-    std::unordered_map<std::string, std::vector<std::string>> netToNodes;
+    PartitionResult result;
+    std::vector<uint8_t> side;  // working partition, by graph node ID
+    int64_t load[2] = {0, 0};  // area or node count of each side, depending on areaDef
+    int64_t cut = 0;
 
-    std::unordered_map<std::string, int> nodeGains;
-    std::unordered_map<std::string, bool> locked;
-    std::map<int, std::unordered_set<std::string>> gainBucket;
+    std::vector<int> pinsOnSide;  // 2 entries per net: pins in A, pins in B
+    std::vector<int64_t> gains;
+    std::vector<uint8_t> locked;
+    std::vector<int> moveSequence;
 
-    int areaA = 0;
-    int areaB = 0;
-    int totalArea = 0;
-    int countA = 0;
-    int countB = 0;
-    int totalCount = 0;
+    // Scores the partition from scratch, independently of the FM bookkeeping
+    Evaluator evaluator;
+    std::vector<uint64_t> sideBits;
+
+    // Gain buckets, one per side. Each bucket is a doubly linked list threaded
+    // through bucketNext / bucketPrev and indexed by gain + maxGain. Heavy net
+    // weights can make the gain range far larger than the graph, and then the
+    // bucket heads live in an ordered map of the gains actually present
+    // instead of an array over the whole range.
+    int64_t maxGain = 0;
+    bool sparseBuckets = false;
+    std::vector<int> bucketHead;
+    std::map<int64_t, int> sparseHeads[2];
+    std::vector<int> bucketNext;
+    std::vector<int> bucketPrev;
+    int topBucket[2] = {0, 0};
 
-    int cap = 0; 
+    int64_t weightOf(int node) const;
+    int* bucketsOf(int side);
+    bool topGain(int side, int64_t& gain);
 
     void initializePartition();
-    void buildNetMappings();
     void computeInitialGains();
-    void updateGain(const std::string& nodeName);
-    void runOnePass();
-    int calculateCutSize() const;
-};
\ No newline at end of file
+    void insertIntoBucket(int node);
+    void removeFromBucket(int node);
+    void adjustGain(int node, int64_t delta);
+    int selectMove();
+    void moveNode(int node);
+    void flipSide(int node);
+    bool runOnePass();
+    void summarize();
+};
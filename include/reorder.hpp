@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+
+#include "hypergraph.hpp"
+
+// Breadth-first (Cuthill-McKee style) locality order. Each connected
+// component is searched from its lowest-degree node; nets are numbered in the
+// order the search first reaches them and their pins follow right after, so
+// nodes that share nets end up with nearby IDs. Nodes without nets go last.
+void localityOrder(const Hypergraph& graph, std::vector<int>& nodeOrder, std::vector<int>& netOrder);
+
+// Permutes the graph into localityOrder in place. Run it once before
+// partitioning; originalId() still maps nodes back to their builder IDs.
+void reorderForLocality(Hypergraph& graph);
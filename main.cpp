@@ -1,39 +1,84 @@
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <filesystem>
 #include <fstream>
 
 #include "parser.hpp"
 #include "partitioner.hpp"
+#include "reorder.hpp"
 
-int main() {
-    // Stuff to change
+int main(int argc, char* argv[]) {
+    // Stuff to change (or pass as: FMPartitioning <aux file> <area|num> <cap> [csr|compact] [noreorder])
     std::string auxFilePath = "benchmarks/example_large/example_large.aux";  // Path to the .aux file
     std::string areaDefStr = "num";  // "area" or "num"
-    int maxArea = 1000;  // max area per partition
-    int maxNum = 130000;     // max number of gates per partition
+    int64_t maxArea = 1000;  // max area per partition
+    int64_t maxNum = 130000;     // max number of gates per partition
+    std::string storageStr = "csr";  // "csr" or "compact" (varint pin lists, less memory)
+    bool reorder = true;  // renumber nodes and nets for cache locality before FM
+
+    if (argc > 1) auxFilePath = argv[1];
+    if (argc > 2) areaDefStr = argv[2];
+    if (argc > 3) {
+        try {
+            size_t used = 0;
+            maxArea = maxNum = std::stoll(argv[3], &used);
+            if (argv[3][used] != '\0') throw std::invalid_argument(argv[3]);
+        } catch (const std::exception&) {
+            std::cerr << "Invalid cap. Use a whole number." << std::endl;
+            return 1;
+        }
+    }
+    for (int i = 4; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "noreorder") {
+            reorder = false;
+        } else if (option == "reorder") {
+            reorder = true;
+        } else {
+            storageStr = option;
+        }
+    }
 
     AreaDef areaDef = AreaDef::Area;
-    int cap;
+    int64_t cap;
 
     if (areaDefStr == "num") {
         areaDef = AreaDef::Num;
-        cap = maxNum;  
+        cap = maxNum;
     } else if (areaDefStr == "area") {
         areaDef = AreaDef::Area;
-        cap = maxArea;  
+        cap = maxArea;
     } else {
         std::cerr << "Invalid area definition. Use 'num' or 'area'." << std::endl;
         return 1;
     }
 
+    StorageMode storage = StorageMode::Csr;
+    if (storageStr == "compact") {
+        storage = StorageMode::Compressed;
+    } else if (storageStr != "csr") {
+        std::cerr << "Invalid storage mode. Use 'csr' or 'compact'." << std::endl;
+        return 1;
+    }
+
     Parser parser;
-    if (!parser.loadAuxFile(auxFilePath)) {
+    HypergraphBuilder builder(storage);
+    std::vector<std::string> nodeNames;
+    if (!parser.loadHypergraph(auxFilePath, builder, nodeNames)) {
         std::cerr << "Failed to load input files." << std::endl;
         return 1;
     }
-
-    Partitioner partitioner(parser.getNodes(), parser.getNets(), areaDef, cap);
+    Hypergraph graph = builder.build();
+    if (reorder) {
+        reorderForLocality(graph);
+    }
+    std::cout << "Hypergraph: " << graph.numNodes() << " nodes, " << graph.numNets() << " nets, "
+              << graph.numPins() << " pins, "
+              << static_cast<double>(graph.storageBytes()) / std::max(graph.numPins(), 1) << " bytes/pin"
+              << std::endl;
+    Partitioner partitioner(graph, areaDef, cap);
 
     // Check if initial partition is possible
     if (!partitioner.isPartitionFeasible()) {
@@ -46,7 +91,8 @@ int main() {
         return 2;
     }
 
-    partitioner.runFM();
+    const PartitionResult& result = partitioner.run();
+    std::cout << "Cut size: " << result.cutSize << " after " << result.passes << " passes" << std::endl;
 
     // Output to file
     std::filesystem::create_directories("results");
@@ -56,7 +102,7 @@ int main() {
         std::cerr << "Could not open output file for writing." << std::endl;
         return 3;
     }
-    partitioner.printResult(fout);
+    partitioner.printResult(fout, nodeNames);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,168 @@
+#include "evaluator.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FM_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+inline int popcount64(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    return static_cast<int>(std::bitset<64>(x).count());
+#endif
+}
+
+// Number of set bits in [begin, end) of a bit array
+inline int popcountRange(const uint64_t* words, int begin, int end) {
+    int w = begin >> 6;
+    int last = end >> 6;
+    uint64_t first = words[w] >> (begin & 63);
+    if (w == last) {
+        return popcount64(first & ((uint64_t(1) << (end - begin)) - 1));
+    }
+
+    int count = popcount64(first);
+    for (w++; w < last; w++) {
+        count += popcount64(words[w]);
+    }
+    if (end & 63) {
+        count += popcount64(words[last] & ((uint64_t(1) << (end & 63)) - 1));
+    }
+    return count;
+}
+
+inline uint64_t sideOf(const uint64_t* sides, int node) {
+    return (sides[node >> 6] >> (node & 63)) & 1;
+}
+
+void gatherPinSidesScalar(const int* pins, int first, int numPins, const uint64_t* sides, uint64_t* out) {
+    for (int i = first; i < numPins; i++) {
+        out[i >> 6] |= sideOf(sides, pins[i]) << (i & 63);
+    }
+}
+
+#ifdef FM_HAVE_AVX2_KERNEL
+__attribute__((target("avx2"))) void gatherPinSidesAvx2(const int* pins, int numPins, const uint64_t* sides,
+                                                         uint64_t* out) {
+    // Gather the 32-bit word holding each pin's side bit, shift that bit up to
+    // the sign position and collect 8 pins per movemask
+    const int* sideWords = reinterpret_cast<const int*>(sides);
+    uint8_t* outBytes = reinterpret_cast<uint8_t*>(out);
+    const __m256i low5 = _mm256_set1_epi32(31);
+
+    int i = 0;
+    for (; i + 8 <= numPins; i += 8) {
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pins + i));
+        __m256i words = _mm256_i32gather_epi32(sideWords, _mm256_srli_epi32(idx, 5), 4);
+        __m256i shift = _mm256_sub_epi32(low5, _mm256_and_si256(idx, low5));
+        __m256i bits = _mm256_sllv_epi32(words, shift);
+        outBytes[i >> 3] = static_cast<uint8_t>(_mm256_movemask_ps(_mm256_castsi256_ps(bits)));
+    }
+    gatherPinSidesScalar(pins, i, numPins, sides, out);
+}
+#endif
+
+// A net is cut when its pins are neither all in A nor all in B
+inline void addNet(EvalResult& eval, int weight, int size, int inB) {
+    int connectivity = (inB > 0) + (inB < size);
+    if (connectivity == 2) {
+        eval.cutSize += weight;
+        eval.cutNets++;
+    }
+    if (connectivity > 0) {
+        eval.km1 += static_cast<int64_t>(weight) * (connectivity - 1);
+    }
+}
+
+}  // namespace
+
+void packSides(const std::vector<uint8_t>& side, std::vector<uint64_t>& bits) {
+    bits.assign((side.size() + 63) / 64, 0);
+    for (size_t v = 0; v < side.size(); v++) {
+        bits[v >> 6] |= static_cast<uint64_t>(side[v] & 1) << (v & 63);
+    }
+}
+
+Evaluator::Evaluator(const Hypergraph& g, EvalKernel k) : graph(g), kernel(k) {
+    if (graph.getStorageMode() == StorageMode::Compressed) {
+        // No pin array to gather from, the pin lists are decoded net by net
+        kernel = EvalKernel::Scalar;
+        return;
+    }
+    if (kernel == EvalKernel::Auto || (kernel == EvalKernel::Avx2 && !avx2Supported())) {
+        kernel = avx2Supported() ? EvalKernel::Avx2 : EvalKernel::Scalar;
+    }
+    // One spare word so popcountRange can always look at words[end >> 6]
+    pinBits.assign(graph.numPins() / 64 + 1, 0);
+}
+
+bool Evaluator::avx2Supported() {
+#ifdef FM_HAVE_AVX2_KERNEL
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+EvalResult Evaluator::evaluate(const std::vector<uint64_t>& sideBits) {
+    if (sideBits.size() < (static_cast<size_t>(graph.numNodes()) + 63) / 64) {
+        throw std::invalid_argument("side bits do not cover every node");
+    }
+
+    EvalResult eval;
+    const uint64_t* sides = sideBits.data();
+
+    if (graph.getStorageMode() == StorageMode::Compressed) {
+        for (int e = 0; e < graph.numNets(); e++) {
+            int size = 0, inB = 0;
+            graph.forEachPin(e, [&](int v) {
+                size++;
+                inB += static_cast<int>(sideOf(sides, v));
+            });
+            addNet(eval, graph.netWeight(e), size, inB);
+        }
+    } else {
+        // Side of every pin, streamed in pin array order
+        std::fill(pinBits.begin(), pinBits.end(), 0);
+#ifdef FM_HAVE_AVX2_KERNEL
+        if (kernel == EvalKernel::Avx2) {
+            gatherPinSidesAvx2(graph.pinData(), graph.numPins(), sides, pinBits.data());
+        } else
+#endif
+        {
+            gatherPinSidesScalar(graph.pinData(), 0, graph.numPins(), sides, pinBits.data());
+        }
+
+        for (int e = 0; e < graph.numNets(); e++) {
+            int begin = graph.netOffset(e);
+            int end = graph.netOffset(e + 1);
+            addNet(eval, graph.netWeight(e), end - begin, popcountRange(pinBits.data(), begin, end));
+        }
+    }
+
+    int64_t totalArea = 0;
+    for (int v = 0; v < graph.numNodes(); v++) {
+        int64_t w = graph.nodeWeight(v);
+        totalArea += w;
+        eval.area[1] += w & -static_cast<int64_t>(sideOf(sides, v));
+    }
+    eval.area[0] = totalArea - eval.area[1];
+
+    for (int v = 0; v < graph.numNodes(); v += 64) {
+        uint64_t word = sides[v >> 6];
+        if (graph.numNodes() - v < 64) {
+            word &= (uint64_t(1) << (graph.numNodes() - v)) - 1;
+        }
+        eval.count[1] += popcount64(word);
+    }
+    eval.count[0] = graph.numNodes() - eval.count[1];
+
+    return eval;
+}
@@ -0,0 +1,322 @@
+#include "hypergraph.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+int varintSize(uint32_t value) {
+    int size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+uint8_t* writeVarint(uint8_t* out, uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+// Appends sorted, distinct IDs as gaps from the previous one
+void appendSortedIds(std::vector<uint8_t>& out, const std::vector<int>& ids) {
+    int prev = 0;
+    uint8_t buffer[5];
+    for (int id : ids) {
+        uint8_t* end = writeVarint(buffer, static_cast<uint32_t>(id - prev));
+        out.insert(out.end(), buffer, end);
+        prev = id;
+    }
+}
+
+uint32_t checkedOffset(size_t bytes) {
+    if (bytes > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("compressed hypergraph exceeds 4 GiB of pin data");
+    }
+    return static_cast<uint32_t>(bytes);
+}
+
+}  // namespace
+
+size_t Hypergraph::storageBytes() const {
+    return netOffsets.size() * sizeof(int) + pins.size() * sizeof(int) +
+           nodeOffsets.size() * sizeof(int) + nodeNetList.size() * sizeof(int) +
+           netByteOffsets.size() * sizeof(uint32_t) + pinBytes.size() +
+           nodeByteOffsets.size() * sizeof(uint32_t) + netBytes.size();
+}
+
+void Hypergraph::permute(const std::vector<int>& nodeOrder, const std::vector<int>& netOrder) {
+    const int nodes = numNodes();
+    const int nets = numNets();
+    if (static_cast<int>(nodeOrder.size()) != nodes || static_cast<int>(netOrder.size()) != nets) {
+        throw std::invalid_argument("reordering must cover every node and net");
+    }
+
+    std::vector<int> newIds(nodes, -1);
+    for (int i = 0; i < nodes; i++) {
+        int v = nodeOrder[i];
+        if (v < 0 || v >= nodes || newIds[v] >= 0) {
+            throw std::invalid_argument("node order is not a permutation");
+        }
+        newIds[v] = i;
+    }
+    std::vector<uint8_t> netSeen(nets, 0);
+    for (int e : netOrder) {
+        if (e < 0 || e >= nets || netSeen[e]) {
+            throw std::invalid_argument("net order is not a permutation");
+        }
+        netSeen[e] = 1;
+    }
+    std::vector<uint8_t>().swap(netSeen);
+
+    // The node -> nets index is rebuilt from scratch at the end. Dropping it
+    // first keeps at most two copies of the net -> pins lists alive, never a
+    // second graph.
+    std::vector<int>().swap(nodeOffsets);
+    std::vector<int>().swap(nodeNetList);
+    std::vector<uint32_t>().swap(nodeByteOffsets);
+    std::vector<uint8_t>().swap(netBytes);
+
+    if (mode == StorageMode::Csr) {
+        std::vector<int> newOffsets;
+        std::vector<int> newPins;
+        newOffsets.reserve(nets + 1);
+        newPins.reserve(pins.size());
+        newOffsets.push_back(0);
+        for (int e : netOrder) {
+            auto first = newPins.end() - newPins.begin();
+            for (int v : netPins(e)) {
+                newPins.push_back(newIds[v]);
+            }
+            std::sort(newPins.begin() + first, newPins.end());
+            newOffsets.push_back(static_cast<int>(newPins.size()));
+        }
+        pins.swap(newPins);
+        netOffsets.swap(newOffsets);
+    } else {
+        std::vector<uint32_t> newOffsets;
+        std::vector<uint8_t> newBytes;
+        newOffsets.reserve(nets + 1);
+        newBytes.reserve(pinBytes.size());
+        newOffsets.push_back(0);
+        std::vector<int> ids;
+        for (int e : netOrder) {
+            ids.clear();
+            forEachPin(e, [&](int v) { ids.push_back(newIds[v]); });
+            std::sort(ids.begin(), ids.end());
+            appendSortedIds(newBytes, ids);
+            newOffsets.push_back(checkedOffset(newBytes.size()));
+        }
+        newBytes.shrink_to_fit();
+        pinBytes.swap(newBytes);
+        netByteOffsets.swap(newOffsets);
+    }
+
+    std::vector<int64_t> weights(nodes);
+    std::vector<int> ids(nodes);
+    for (int i = 0; i < nodes; i++) {
+        weights[i] = nodeWeights[nodeOrder[i]];
+        ids[i] = originalId(nodeOrder[i]);
+    }
+    nodeWeights.swap(weights);
+    originalIds.swap(ids);
+
+    std::vector<int> newNetWeights(nets);
+    for (int j = 0; j < nets; j++) {
+        newNetWeights[j] = netWeights[netOrder[j]];
+    }
+    netWeights.swap(newNetWeights);
+
+    buildNodeIndex();
+}
+
+void Hypergraph::buildNodeIndex() {
+    const int nodes = numNodes();
+    const int nets = numNets();
+    std::vector<int64_t> weightedDegree(nodes, 0);
+
+    if (mode == StorageMode::Csr) {
+        // Counting sort of the pins by node gives the node -> nets index
+        nodeOffsets.assign(nodes + 1, 0);
+        for (int pin : pins) {
+            nodeOffsets[pin + 1]++;
+        }
+        for (int v = 0; v < nodes; v++) {
+            nodeOffsets[v + 1] += nodeOffsets[v];
+        }
+
+        nodeNetList.resize(pins.size());
+        std::vector<int> fill(nodeOffsets.begin(), nodeOffsets.end() - 1);
+        for (int e = 0; e < nets; e++) {
+            for (int v : netPins(e)) {
+                nodeNetList[fill[v]++] = e;
+                weightedDegree[v] += netWeights[e];
+            }
+        }
+    } else {
+        // Pass 1: size of every node's encoded net list. Nets are visited in
+        // increasing order, so each list comes out sorted.
+        std::vector<int> lastNet(nodes, 0);
+        std::vector<size_t> bytes(nodes + 1, 0);
+        for (int e = 0; e < nets; e++) {
+            forEachPin(e, [&](int v) {
+                bytes[v + 1] += varintSize(static_cast<uint32_t>(e - lastNet[v]));
+                lastNet[v] = e;
+                weightedDegree[v] += netWeights[e];
+            });
+        }
+        nodeByteOffsets.resize(nodes + 1);
+        nodeByteOffsets[0] = 0;
+        for (int v = 0; v < nodes; v++) {
+            bytes[v + 1] += bytes[v];
+            nodeByteOffsets[v + 1] = checkedOffset(bytes[v + 1]);
+        }
+        std::vector<size_t>().swap(bytes);
+
+        // Pass 2: encode
+        netBytes.resize(nodeByteOffsets[nodes]);
+        std::vector<uint32_t> cursor(nodeByteOffsets.begin(), nodeByteOffsets.end() - 1);
+        std::fill(lastNet.begin(), lastNet.end(), 0);
+        for (int e = 0; e < nets; e++) {
+            forEachPin(e, [&](int v) {
+                uint8_t* out = netBytes.data() + cursor[v];
+                cursor[v] = static_cast<uint32_t>(writeVarint(out, static_cast<uint32_t>(e - lastNet[v])) -
+                                                  netBytes.data());
+                lastNet[v] = e;
+            });
+        }
+    }
+
+    maxDegree = 0;
+    for (int64_t d : weightedDegree) {
+        maxDegree = std::max(maxDegree, d);
+    }
+}
+
+HypergraphBuilder::HypergraphBuilder(StorageMode m) : mode(m) {
+    graph.mode = mode;
+}
+
+void HypergraphBuilder::reserve(int nodes, int nets, int pins) {
+    graph.nodeWeights.reserve(nodes);
+    graph.netWeights.reserve(nets);
+    if (mode == StorageMode::Csr) {
+        graph.netOffsets.reserve(nets + 1);
+        graph.pins.reserve(pins);
+    } else {
+        newIds.reserve(nodes);
+        graph.netByteOffsets.reserve(nets + 1);
+        graph.pinBytes.reserve(pins * 2);
+    }
+}
+
+int HypergraphBuilder::addNode(int64_t weight) {
+    if (weight < 0) {
+        throw std::invalid_argument("node weight must not be negative");
+    }
+    graph.nodeWeights.push_back(weight);
+    if (mode == StorageMode::Compressed) {
+        newIds.push_back(-1);
+    }
+    return numNodes() - 1;
+}
+
+int HypergraphBuilder::addNet(const std::vector<int>& pins, int weight) {
+    return addNet(pins.data(), static_cast<int>(pins.size()), weight);
+}
+
+int HypergraphBuilder::addNet(const int* pins, int count, int weight) {
+    if (weight <= 0) {
+        throw std::invalid_argument("net weight must be positive");
+    }
+    for (int i = 0; i < count; i++) {
+        if (pins[i] < 0 || pins[i] >= numNodes()) {
+            throw std::out_of_range("net pin refers to an unknown node");
+        }
+    }
+
+    if (mode == StorageMode::Csr) {
+        if (graph.netOffsets.empty()) {
+            graph.netOffsets.push_back(0);
+        }
+        auto first = graph.pins.insert(graph.pins.end(), pins, pins + count);
+        std::sort(first, graph.pins.end());
+        graph.pins.erase(std::unique(first, graph.pins.end()), graph.pins.end());
+        graph.netOffsets.push_back(static_cast<int>(graph.pins.size()));
+    } else {
+        if (graph.netByteOffsets.empty()) {
+            graph.netByteOffsets.push_back(0);
+        }
+
+        // Number nodes as nets first touch them, then store the sorted gaps
+        scratch.clear();
+        for (int i = 0; i < count; i++) {
+            int& id = newIds[pins[i]];
+            if (id < 0) id = nextId++;
+            scratch.push_back(id);
+        }
+        std::sort(scratch.begin(), scratch.end());
+        scratch.erase(std::unique(scratch.begin(), scratch.end()), scratch.end());
+
+        appendSortedIds(graph.pinBytes, scratch);
+        graph.pinCount += static_cast<int>(scratch.size());
+        graph.netByteOffsets.push_back(checkedOffset(graph.pinBytes.size()));
+    }
+
+    graph.netWeights.push_back(weight);
+    return numNets() - 1;
+}
+
+Hypergraph HypergraphBuilder::build() {
+    if (mode == StorageMode::Csr) {
+        buildCsr();
+    } else {
+        buildCompressed();
+    }
+
+    Hypergraph result = std::move(graph);
+    graph = Hypergraph();
+    graph.mode = mode;
+    newIds.clear();
+    nextId = 0;
+    return result;
+}
+
+void HypergraphBuilder::buildCsr() {
+    if (graph.netOffsets.empty()) {
+        graph.netOffsets.push_back(0);
+    }
+    graph.pinCount = static_cast<int>(graph.pins.size());
+    graph.buildNodeIndex();
+}
+
+void HypergraphBuilder::buildCompressed() {
+    const int nodes = numNodes();
+    if (graph.netByteOffsets.empty()) {
+        graph.netByteOffsets.push_back(0);
+    }
+
+    // Nodes that no net touched go last
+    for (int& id : newIds) {
+        if (id < 0) id = nextId++;
+    }
+    graph.originalIds.resize(nodes);
+    std::vector<int64_t> weights(nodes);
+    for (int v = 0; v < nodes; v++) {
+        graph.originalIds[newIds[v]] = v;
+        weights[newIds[v]] = graph.nodeWeights[v];
+    }
+    graph.nodeWeights.swap(weights);
+    std::vector<int>().swap(newIds);
+
+    graph.pinBytes.shrink_to_fit();
+    graph.netByteOffsets.shrink_to_fit();
+    graph.buildNodeIndex();
+}
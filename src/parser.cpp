@@ -3,8 +3,44 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <utility>
 
 bool Parser::loadAuxFile(const std::string& path) {
+    if (!readAuxFile(path)) return false;
+    return loadNodesFile(nodesFilePath, [this](Node& node) { nodes[node.name] = std::move(node); }) &&
+           loadNetsFile(netsFilePath, [this](Net& net) { nets[net.name] = std::move(net); });
+}
+
+bool Parser::loadHypergraph(const std::string& auxPath, HypergraphBuilder& builder,
+                            std::vector<std::string>& nodeNames) {
+    if (!readAuxFile(auxPath)) return false;
+
+    std::unordered_map<std::string, int> nodeIds;
+    nodeNames.clear();
+    bool nodesLoaded = loadNodesFile(nodesFilePath, [&](Node& node) {
+        if (node.type == NodeType::Terminal || node.type == NodeType::TerminalNI ||
+            nodeIds.count(node.name)) {
+            return;
+        }
+        nodeIds[node.name] = builder.addNode(static_cast<int64_t>(node.width) * node.height);
+        nodeNames.push_back(node.name);
+    });
+    if (!nodesLoaded) return false;
+
+    std::vector<int> pins;
+    return loadNetsFile(netsFilePath, [&](Net& net) {
+        pins.clear();
+        for (const auto& [nodeName, _] : net.pins) {
+            auto it = nodeIds.find(nodeName);
+            if (it != nodeIds.end()) {
+                pins.push_back(it->second);
+            }
+        }
+        builder.addNet(pins);
+    });
+}
+
+bool Parser::readAuxFile(const std::string& path) {
     std::ifstream file(path);
     if (!file.is_open()) return false;
 
@@ -23,11 +59,10 @@ bool Parser::loadAuxFile(const std::string& path) {
         }
     }
 
-    if (nodesFilePath.empty() || netsFilePath.empty()) return false;
-    return loadNodesFile(nodesFilePath) && loadNetsFile(netsFilePath);
+    return !nodesFilePath.empty() && !netsFilePath.empty();
 }
 
-bool Parser::loadNodesFile(const std::string& path) {
+bool Parser::loadNodesFile(const std::string& path, const std::function<void(Node&)>& onNode) {
     std::ifstream file(path);
     if (!file.is_open()) return false;
 
@@ -58,13 +93,14 @@ bool Parser::loadNodesFile(const std::string& path) {
             }
         }
 
-        nodes[name] = Node(name, width, height, type);
+        Node node(name, width, height, type);
+        onNode(node);
     }
 
     return true;
 }
 
-bool Parser::loadNetsFile(const std::string& path) {
+bool Parser::loadNetsFile(const std::string& path, const std::function<void(Net&)>& onNet) {
     std::ifstream file(path);
     if (!file.is_open()) return false;
 
@@ -89,7 +125,7 @@ bool Parser::loadNetsFile(const std::string& path) {
         if (word == "NetDegree") {
             // Save previous net if needed
             if (readingNet && !currentNet.name.empty()) {
-                nets[currentNet.name] = currentNet;
+                onNet(currentNet);
             }
             std::string colon, netName;
             iss >> colon >> pinCount >> netName;
@@ -103,14 +139,14 @@ bool Parser::loadNetsFile(const std::string& path) {
             currentNet.pins.emplace_back(nodeName, direction);
 
             if (--pinCount == 0) {
-                nets[currentNet.name] = currentNet;
+                onNet(currentNet);
                 readingNet = false;
             }
         }
     }
     // Save the last net if file doesn't end with NetDegree
     if (readingNet && !currentNet.name.empty() && pinCount == 0) {
-        nets[currentNet.name] = currentNet;
+        onNet(currentNet);
     }
 
     return true;
@@ -158,4 +194,4 @@ const std::unordered_map<std::string, Node>& Parser::getNodes() const {
 
 const std::unordered_map<std::string, Net>& Parser::getNets() const {
     return nets;
-}
\ No newline at end of file
+}
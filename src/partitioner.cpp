@@ -1,404 +1,328 @@
 #include "partitioner.hpp"
 
-Partitioner::Partitioner(const std::unordered_map<std::string, Node>& n,
-                         const std::unordered_map<std::string, Net>& e,
-                         AreaDef def,
-                         int capVal)
-    : nodes(n), nets(e), areaDef(def), cap(capVal) {
-    buildNetMappings();
+#include <algorithm>
+#include <cassert>
+
+Partitioner::Partitioner(const Hypergraph& g) : graph(g), evaluator(g) {
+    const int nodes = graph.numNodes();
+    maxGain = graph.maxWeightedDegree();
+
+    side.assign(nodes, 0);
+    result.side.assign(nodes, 0);
+    pinsOnSide.assign(2 * static_cast<size_t>(graph.numNets()), 0);
+    gains.assign(nodes, 0);
+    locked.assign(nodes, 0);
+    moveSequence.reserve(nodes);
+
+    // A dense array costs O(maxGain) to clear every pass, which stays within
+    // the O(pins) of the pass itself unless the nets are heavily weighted
+    sparseBuckets = maxGain > static_cast<int64_t>(graph.numPins()) + 1024;
+    if (!sparseBuckets) {
+        bucketHead.assign(2 * static_cast<size_t>(2 * maxGain + 1), -1);
+    }
+    bucketNext.assign(nodes, -1);
+    bucketPrev.assign(nodes, -1);
+}
+
+Partitioner::Partitioner(const Hypergraph& g, AreaDef def, int64_t capVal) : Partitioner(g) {
+    reset(capVal, def);
+}
+
+void Partitioner::reset(int64_t capVal, AreaDef def) {
+    cap = capVal;
+    areaDef = def;
     initializePartition();
-    computeInitialGains();
+    result.passes = 0;
+    result.feasible = isPartitionFeasible();
+    summarize();
+    cut = result.cutSize;
 }
 
-void Partitioner::buildNetMappings() {
-    for (const auto& [netName, net] : nets) {
-        for (const auto& [nodeName, _] : net.pins) {
-            // Only add mappings for non-terminal nodes or if the node exists
-            if (nodes.count(nodeName) &&
-                nodes.at(nodeName).type != NodeType::Terminal &&
-                nodes.at(nodeName).type != NodeType::TerminalNI) {
-                nodeToNets[nodeName].push_back(netName);
-            }
-            // We still need all nodes in netToNodes for cut calculation
-            netToNodes[netName].push_back(nodeName);
-        }
-    }
+int64_t Partitioner::weightOf(int node) const {
+    return areaDef == AreaDef::Area ? graph.nodeWeight(node) : 1;
 }
 
-void Partitioner::initializePartition() {
-    areaA = areaB = totalArea = 0;
-    countA = countB = totalCount = 0;
+int* Partitioner::bucketsOf(int side) {
+    return bucketHead.data() + side * (2 * maxGain + 1);
+}
 
-    for (const auto& [name, node] : nodes) {
-        if (node.type == NodeType::Terminal || node.type == NodeType::TerminalNI) {
-            continue;
-        }
+void Partitioner::initializePartition() {
+    load[0] = load[1] = 0;
 
-        int area = node.width * node.height;
-        totalArea += area;
-        totalCount++;
+    for (int v = 0; v < graph.numNodes(); v++) {
+        int64_t w = weightOf(v);
 
         // Assign to the smaller partition, while respecting cap constraints
-        if (areaDef == AreaDef::Area) {
-            // Check which partition has smaller area and if adding to it stays within cap
-            if (areaA <= areaB && areaA + area <= cap) {
-                nodeToPartition[name] = "A";
-                areaA += area;
-            } else if (areaB + area <= cap) {
-                nodeToPartition[name] = "B";
-                areaB += area;
-            } else if (areaA + area <= cap) {
-                // If B is full but A still has space
-                nodeToPartition[name] = "A";
-                areaA += area;
-            } else {
-                // Neither partition can fit this node within cap
-                // Assign to the one with more space left
-                if (cap - areaA >= cap - areaB) {
-                    nodeToPartition[name] = "A";
-                    areaA += area;
-                } else {
-                    nodeToPartition[name] = "B";
-                    areaB += area;
-                }
-            }
-        } else {  // AreaDef::Num
-            // Check which partition has fewer nodes and if adding to it stays within cap
-            if (countA <= countB && countA + 1 <= cap) {
-                nodeToPartition[name] = "A";
-                countA++;
-            } else if (countB + 1 <= cap) {
-                nodeToPartition[name] = "B";
-                countB++;
-            } else if (countA + 1 <= cap) {
-                // If B is full but A still has space
-                nodeToPartition[name] = "A";
-                countA++;
-            } else {
-                // Neither partition can fit this node within cap
-                // Assign to the one with more space left
-                if (cap - countA >= cap - countB) {
-                    nodeToPartition[name] = "A";
-                    countA++;
-                } else {
-                    nodeToPartition[name] = "B";
-                    countB++;
-                }
-            }
+        int s;
+        if (load[0] <= load[1] && load[0] + w <= cap) {
+            s = 0;
+        } else if (load[1] + w <= cap) {
+            s = 1;
+        } else if (load[0] + w <= cap) {
+            // If B is full but A still has space
+            s = 0;
+        } else {
+            // Neither partition can fit this node within cap
+            // Assign to the one with more space left
+            s = load[0] <= load[1] ? 0 : 1;
         }
-        locked[name] = false;
+        side[v] = static_cast<uint8_t>(s);
+        load[s] += w;
+    }
+
+    std::fill(pinsOnSide.begin(), pinsOnSide.end(), 0);
+    for (int e = 0; e < graph.numNets(); e++) {
+        graph.forEachPin(e, [&](int v) { pinsOnSide[2 * e + side[v]]++; });
     }
 }
 
 void Partitioner::computeInitialGains() {
-    nodeGains.clear();
-    gainBucket.clear();
-
-    for (const auto& [nodeName, part] : nodeToPartition) {
-        // Skip terminal nodes completely in gain calculation
-        if (nodes.count(nodeName) &&
-            (nodes.at(nodeName).type == NodeType::Terminal ||
-             nodes.at(nodeName).type == NodeType::TerminalNI)) {
-            continue;
-        }
-
-        int gain = 0;
-        for (const auto& netName : nodeToNets[nodeName]) {
-            const auto& nodesInNet = netToNodes[netName];
-            int fromCount = 0;
-            int toCount = 0;
-            for (const auto& n : nodesInNet) {
-                // Only consider nodes in partitions for gain calculation
-                if (nodeToPartition.count(n) > 0) {
-                    if (nodeToPartition[n] == part) {
-                        fromCount++;
-                    } else {
-                        toCount++;
-                    }
-                }
-            }
-            if (fromCount == 1) gain++;
-            if (toCount == 0) gain--;
-        }
-        nodeGains[nodeName] = gain;
-        gainBucket[gain].insert(nodeName);
+    std::fill(bucketHead.begin(), bucketHead.end(), -1);
+    sparseHeads[0].clear();
+    sparseHeads[1].clear();
+    topBucket[0] = topBucket[1] = -1;
+
+    for (int v = 0; v < graph.numNodes(); v++) {
+        int from = side[v];
+        int64_t gain = 0;
+        graph.forEachNet(v, [&](int e) {
+            if (pinsOnSide[2 * e + from] == 1) gain += graph.netWeight(e);
+            if (pinsOnSide[2 * e + (1 - from)] == 0) gain -= graph.netWeight(e);
+        });
+        gains[v] = gain;
+        locked[v] = 0;
+        insertIntoBucket(v);
     }
 }
 
-void Partitioner::updateGain(const std::string& nodeName) {
-    int oldGain = nodeGains[nodeName];
-    gainBucket[oldGain].erase(nodeName);
-    if (gainBucket[oldGain].empty()) {
-        gainBucket.erase(oldGain);
+void Partitioner::insertIntoBucket(int node) {
+    int s = side[node];
+    int* head;
+    if (sparseBuckets) {
+        head = &sparseHeads[s].try_emplace(gains[node], -1).first->second;
+    } else {
+        int index = static_cast<int>(gains[node] + maxGain);
+        head = bucketsOf(s) + index;
+        topBucket[s] = std::max(topBucket[s], index);
     }
 
-    int gain = 0;
-    std::string part = nodeToPartition[nodeName];
-    for (const auto& netName : nodeToNets[nodeName]) {
-        const auto& nodesInNet = netToNodes[netName];
-        int fromCount = 0, toCount = 0;
-        for (const auto& n : nodesInNet) {
-            if (nodeToPartition[n] == part)
-                fromCount++;
-            else
-                toCount++;
-        }
-        if (fromCount == 1) gain++;
-        if (toCount == 0) gain--;
+    bucketPrev[node] = -1;
+    bucketNext[node] = *head;
+    if (*head >= 0) {
+        bucketPrev[*head] = node;
     }
-    nodeGains[nodeName] = gain;
-    gainBucket[gain].insert(nodeName);
+    *head = node;
 }
 
-void Partitioner::runFM() {
-    int prevCut = calculateCutSize();
-    while (true) {
-        runOnePass();
-        int newCut = calculateCutSize();
-        if (newCut < prevCut) {
-            prevCut = newCut;
+void Partitioner::removeFromBucket(int node) {
+    if (bucketPrev[node] >= 0) {
+        bucketNext[bucketPrev[node]] = bucketNext[node];
+    } else if (sparseBuckets) {
+        auto it = sparseHeads[side[node]].find(gains[node]);
+        if (bucketNext[node] >= 0) {
+            it->second = bucketNext[node];
         } else {
-            break;
+            sparseHeads[side[node]].erase(it);
         }
+    } else {
+        bucketsOf(side[node])[gains[node] + maxGain] = bucketNext[node];
+    }
+    if (bucketNext[node] >= 0) {
+        bucketPrev[bucketNext[node]] = bucketPrev[node];
     }
 }
 
-void Partitioner::runOnePass() {
-    std::unordered_map<std::string, std::string> originalPartition = nodeToPartition;
-    int originalAreaA = areaA;
-    int originalAreaB = areaB;
-    int originalCountA = countA;
-    int originalCountB = countB;
-
-    int bestCutSize = calculateCutSize();
-    int currentCutSize = bestCutSize;
-    int movesToBest = 0;
-    int movesCount = 0;
-
-    std::vector<int> moveGains;
-    std::vector<std::string> moveSequence;
+void Partitioner::adjustGain(int node, int64_t delta) {
+    removeFromBucket(node);
+    gains[node] += delta;
+    insertIntoBucket(node);
+}
 
-    for (auto& [k, v] : locked) {
-        v = false;
+// Highest gain with a node in it on the given side, false when the side is empty
+bool Partitioner::topGain(int side, int64_t& gain) {
+    if (sparseBuckets) {
+        if (sparseHeads[side].empty()) return false;
+        gain = sparseHeads[side].rbegin()->first;
+        return true;
     }
 
-    while (!gainBucket.empty() && movesCount < nodeToPartition.size()) {
-        auto it = gainBucket.rbegin();
-        int maxGain = it->first;
-        auto& candidates = it->second;
-
-        if (candidates.empty()) {
-            gainBucket.erase(maxGain);
-            continue;
-        }
+    // Drop empty buckets off the top
+    int* heads = bucketsOf(side);
+    while (topBucket[side] >= 0 && heads[topBucket[side]] < 0) {
+        topBucket[side]--;
+    }
+    gain = topBucket[side] - maxGain;
+    return topBucket[side] >= 0;
+}
 
-        std::string bestNode = *candidates.begin();
-        candidates.erase(candidates.begin());
-        if (candidates.empty()) {
-            gainBucket.erase(maxGain);
+int Partitioner::selectMove() {
+    while (true) {
+        int64_t gain[2];
+        bool has0 = topGain(0, gain[0]);
+        bool has1 = topGain(1, gain[1]);
+        if (!has0 && !has1) {
+            return -1;
         }
 
-        if (locked[bestNode]) {
-            continue;
+        // Take the higher gain; on a tie move out of the heavier side
+        int s;
+        if (!has0 || !has1) {
+            s = has0 ? 0 : 1;
+        } else if (gain[0] != gain[1]) {
+            s = gain[0] > gain[1] ? 0 : 1;
+        } else {
+            s = load[0] >= load[1] ? 0 : 1;
         }
 
-        std::string& part = nodeToPartition[bestNode];
-        std::string otherPart = (part == "A") ? "B" : "A";
-        int area = nodes.at(bestNode).width * nodes.at(bestNode).height;
+        int node = sparseBuckets ? sparseHeads[s].rbegin()->second : bucketsOf(s)[topBucket[s]];
+        removeFromBucket(node);
+        locked[node] = 1;
 
-        // Enforce cap for area or number 
-        bool canMove = true;
-        if (areaDef == AreaDef::Area) {
-            if (otherPart == "A" && areaA + area > cap) {
-                canMove = false;
-            }
-            if (otherPart == "B" && areaB + area > cap) {
-                canMove = false;
-            }
-        } else {  // AreaDef::Num
-            if (otherPart == "A" && countA + 1 > cap) {
-                canMove = false;
-            }
-            if (otherPart == "B" && countB + 1 > cap) {
-                canMove = false;
-            }
-        }
-        if (!canMove) {
-            continue;
+        // A node that would overflow the other side sits out the rest of the pass
+        if (load[1 - s] + weightOf(node) <= cap) {
+            return node;
         }
+    }
+}
 
-        // Update partition and stats 
-        part = otherPart;
-        if (areaDef == AreaDef::Area) {
-            if (part == "A") {
-                areaA += area;
-                areaB -= area;
-            } else {
-                areaB += area;
-                areaA -= area;
-            }
-        } else {
-            if (part == "A") {
-                countA++;
-                countB--;
-            } else {
-                countB++;
-                countA--;
-            }
+void Partitioner::moveNode(int node) {
+    const int from = side[node];
+    const int to = 1 - from;
+
+    graph.forEachNet(node, [&](int e) {
+        const int w = graph.netWeight(e);
+        int& fromCount = pinsOnSide[2 * e + from];
+        int& toCount = pinsOnSide[2 * e + to];
+
+        // Before the move: the net is about to become (more) cut
+        if (toCount == 0) {
+            graph.forEachPin(e, [&](int u) {
+                if (!locked[u]) adjustGain(u, w);
+            });
+        } else if (toCount == 1) {
+            int u = graph.findPin(e, [&](int v) { return !locked[v] && side[v] == to; });
+            if (u >= 0) adjustGain(u, -w);
         }
-        locked[bestNode] = true;
 
-        for (const auto& netName : nodeToNets[bestNode]) {
-            for (const auto& neighbor : netToNodes[netName]) {
-                if (neighbor != bestNode && !locked[neighbor]) {
-                    updateGain(neighbor);
-                }
-            }
+        fromCount--;
+        toCount++;
+
+        // After the move: the net may have left the from side entirely
+        if (fromCount == 0) {
+            graph.forEachPin(e, [&](int u) {
+                if (!locked[u]) adjustGain(u, -w);
+            });
+        } else if (fromCount == 1) {
+            int u = graph.findPin(e, [&](int v) { return !locked[v] && v != node && side[v] == from; });
+            if (u >= 0) adjustGain(u, w);
         }
+    });
 
-        moveSequence.push_back(bestNode);
-        moveGains.push_back(maxGain);
-        movesCount++;
-
-        currentCutSize = calculateCutSize();
+    side[node] = static_cast<uint8_t>(to);
+    int64_t w = weightOf(node);
+    load[from] -= w;
+    load[to] += w;
+}
 
-        if (currentCutSize < bestCutSize) {
-            bestCutSize = currentCutSize;
-            movesToBest = movesCount;
-        }
-    }
+void Partitioner::flipSide(int node) {
+    const int from = side[node];
+    const int to = 1 - from;
+    graph.forEachNet(node, [&](int e) {
+        pinsOnSide[2 * e + from]--;
+        pinsOnSide[2 * e + to]++;
+    });
+    side[node] = static_cast<uint8_t>(to);
+    int64_t w = weightOf(node);
+    load[from] -= w;
+    load[to] += w;
+}
 
-    if (movesToBest > 0) {
-        nodeToPartition = originalPartition;
-        areaA = originalAreaA;
-        areaB = originalAreaB;
-        countA = originalCountA;
-        countB = originalCountB;
-
-        for (int i = 0; i < movesToBest; i++) {
-            std::string nodeName = moveSequence[i];
-            std::string& part = nodeToPartition[nodeName];
-            std::string otherPart = (part == "A") ? "B" : "A";
-            int area = nodes.at(nodeName).width * nodes.at(nodeName).height;
-
-            part = otherPart;
-
-            if (areaDef == AreaDef::Area) {
-                if (part == "A") {
-                    areaA += area;
-                    areaB -= area;
-                } else {
-                    areaB += area;
-                    areaA -= area;
-                }
-            } else {  // AreaDef::Num
-                if (part == "A") {
-                    countA++;
-                    countB--;
-                } else {
-                    countB++;
-                    countA--;
-                }
-            }
-        }
-    } else {
-        nodeToPartition = originalPartition;
-        areaA = originalAreaA;
-        areaB = originalAreaB;
-        countA = originalCountA;
-        countB = originalCountB;
+const PartitionResult& Partitioner::run() {
+    result.feasible = isPartitionFeasible();
+    if (!result.feasible) {
+        return result;
     }
 
-    for (auto& [k, v] : locked) {
-        v = false;
+    while (runOnePass()) {
+        result.passes++;
     }
+    summarize();
+    assert(result.cutSize == cut);
+    return result;
 }
 
-int Partitioner::calculateCutSize() const {
-    int cut = 0;
-    for (const auto& [netName, net] : nets) {
-        std::unordered_set<std::string> parts;
-        for (const auto& [nodeName, _] : net.pins) {
-            // Only consider nodes that are in a partition (non-terminals)
-            if (nodeToPartition.count(nodeName) > 0) {
-                parts.insert(nodeToPartition.at(nodeName));
-            }
-        }
-        if (parts.size() > 1) {
-            cut++;
+bool Partitioner::runOnePass() {
+    computeInitialGains();
+    moveSequence.clear();
+
+    int64_t currentCut = cut;
+    int64_t bestCut = cut;
+    size_t movesToBest = 0;
+
+    for (int node = selectMove(); node >= 0; node = selectMove()) {
+        currentCut -= gains[node];
+        moveNode(node);
+        moveSequence.push_back(node);
+
+        if (currentCut < bestCut) {
+            bestCut = currentCut;
+            movesToBest = moveSequence.size();
         }
     }
-    return cut;
-}
 
-void Partitioner::printResult() const {
-    std::cout << "Partition A:" << std::endl;
-    for (const auto& [name, part] : nodeToPartition) {
-        if (part == "A") std::cout << "  " << name << std::endl;
-    }
-    std::cout << "Partition B:" << std::endl;
-    for (const auto& [name, part] : nodeToPartition) {
-        if (part == "B") std::cout << "  " << name << std::endl;
+    // Undo every move made after the best prefix
+    for (size_t i = moveSequence.size(); i > movesToBest; i--) {
+        flipSide(moveSequence[i - 1]);
     }
+    cut = bestCut;
+    return movesToBest > 0;
 }
 
-void Partitioner::printResult(std::ostream& os) const {
-    os << "Partition A:" << std::endl;
-    for (const auto& [name, part] : nodeToPartition) {
-        if (part == "A") {
-            os << "  " << name << std::endl;
-        }
-    }
-    os << "Partition B:" << std::endl;
-    for (const auto& [name, part] : nodeToPartition) {
-        if (part == "B") {
-            os << "  " << name << std::endl;
-        }
+void Partitioner::summarize() {
+    packSides(side, sideBits);
+    EvalResult eval = evaluator.evaluate(sideBits);
+
+    for (int v = 0; v < graph.numNodes(); v++) {
+        result.side[graph.originalId(v)] = side[v];
     }
+
+    result.cutSize = eval.cutSize;
+    result.km1 = eval.km1;
+    result.areaA = eval.area[0];
+    result.areaB = eval.area[1];
+    result.countA = eval.count[0];
+    result.countB = eval.count[1];
+}
+
+const PartitionResult& Partitioner::getResult() const {
+    return result;
 }
 
 bool Partitioner::isPartitionFeasible() const {
     // Check if any node is too large for any partition
-    for (const auto& [name, node] : nodes) {
-        if (node.type == NodeType::Terminal || node.type == NodeType::TerminalNI) {
-            continue;
-        }
-        int area = node.width * node.height;
-        if (areaDef == AreaDef::Area && area > cap) {
-            return false;
+    if (areaDef == AreaDef::Area) {
+        for (int v = 0; v < graph.numNodes(); v++) {
+            if (graph.nodeWeight(v) > cap) {
+                return false;
+            }
         }
     }
 
-    // Count nodes in each partition
-    int countInA = 0, countInB = 0;
-    int areaInA = 0, areaInB = 0;
-
-    for (const auto& [name, part] : nodeToPartition) {
-        if (nodes.at(name).type == NodeType::Terminal ||
-            nodes.at(name).type == NodeType::TerminalNI) {
-            continue;
-        }
+    // Check if partitions exceed caps
+    return load[0] <= cap && load[1] <= cap;
+}
 
-        int area = nodes.at(name).width * nodes.at(name).height;
-        if (part == "A") {
-            countInA++;
-            areaInA += area;
-        } else {
-            countInB++;
-            areaInB += area;
+void Partitioner::printResult(std::ostream& os, const std::vector<std::string>& nodeNames) const {
+    os << "Partition A:" << std::endl;
+    for (int v = 0; v < graph.numNodes(); v++) {
+        if (result.side[v] == 0) {
+            os << "  " << nodeNames[v] << '\n';
         }
     }
-
-    // Check if partitions exceed caps
-    if (areaDef == AreaDef::Area && (areaInA > cap || areaInB > cap)) {
-        return false;
-    }
-
-    if (areaDef == AreaDef::Num && (countInA > cap || countInB > cap)) {
-        return false;
+    os << "Partition B:" << std::endl;
+    for (int v = 0; v < graph.numNodes(); v++) {
+        if (result.side[v] == 1) {
+            os << "  " << nodeNames[v] << '\n';
+        }
     }
-
-    // Check if all nodes are assigned
-    int assigned = countInA + countInB;
-    return assigned == totalCount;
-}
\ No newline at end of file
+}
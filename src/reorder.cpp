@@ -0,0 +1,71 @@
+#include "reorder.hpp"
+
+#include <cstdint>
+
+void localityOrder(const Hypergraph& graph, std::vector<int>& nodeOrder, std::vector<int>& netOrder) {
+    const int nodes = graph.numNodes();
+    const int nets = graph.numNets();
+
+    std::vector<int> degree(nodes, 0);
+    int maxDegree = 0;
+    for (int e = 0; e < nets; e++) {
+        graph.forEachPin(e, [&](int v) {
+            if (++degree[v] > maxDegree) maxDegree = degree[v];
+        });
+    }
+
+    // Counting sort by degree gives the start candidates, lowest degree first
+    std::vector<int> starts(nodes);
+    std::vector<int> firstOfDegree(maxDegree + 2, 0);
+    for (int v = 0; v < nodes; v++) {
+        firstOfDegree[degree[v] + 1]++;
+    }
+    for (int d = 0; d <= maxDegree; d++) {
+        firstOfDegree[d + 1] += firstOfDegree[d];
+    }
+    for (int v = 0; v < nodes; v++) {
+        starts[firstOfDegree[degree[v]]++] = v;
+    }
+
+    nodeOrder.clear();
+    netOrder.clear();
+    nodeOrder.reserve(nodes);
+    netOrder.reserve(nets);
+    std::vector<uint8_t> nodeSeen(nodes, 0);
+    std::vector<uint8_t> netSeen(nets, 0);
+
+    for (int start : starts) {
+        if (nodeSeen[start] || degree[start] == 0) continue;
+        nodeSeen[start] = 1;
+        nodeOrder.push_back(start);
+
+        // nodeOrder doubles as the BFS queue
+        for (size_t head = nodeOrder.size() - 1; head < nodeOrder.size(); head++) {
+            graph.forEachNet(nodeOrder[head], [&](int e) {
+                if (netSeen[e]) return;
+                netSeen[e] = 1;
+                netOrder.push_back(e);
+                graph.forEachPin(e, [&](int u) {
+                    if (!nodeSeen[u]) {
+                        nodeSeen[u] = 1;
+                        nodeOrder.push_back(u);
+                    }
+                });
+            });
+        }
+    }
+
+    for (int v = 0; v < nodes; v++) {
+        if (!nodeSeen[v]) nodeOrder.push_back(v);
+    }
+    for (int e = 0; e < nets; e++) {
+        if (!netSeen[e]) netOrder.push_back(e);
+    }
+}
+
+void reorderForLocality(Hypergraph& graph) {
+    std::vector<int> nodeOrder;
+    std::vector<int> netOrder;
+    localityOrder(graph, nodeOrder, netOrder);
+    graph.permute(nodeOrder, netOrder);
+}
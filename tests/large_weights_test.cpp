@@ -0,0 +1,86 @@
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "partitioner.hpp"
+
+// Heavy net weights must not change how FM moves, only the scale of the gains,
+// and must not overflow the degree / gain sums.
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        std::cerr << "FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+Hypergraph randomGraph(StorageMode mode, int scale) {
+    std::mt19937 rng(7);
+    HypergraphBuilder builder(mode);
+    const int nodes = 400, nets = 600;
+    for (int v = 0; v < nodes; v++) {
+        builder.addNode(1 + rng() % 5);
+    }
+    std::vector<int> pins;
+    for (int e = 0; e < nets; e++) {
+        pins.clear();
+        int size = 2 + rng() % 4;
+        for (int k = 0; k < size; k++) {
+            pins.push_back(rng() % nodes);
+        }
+        builder.addNet(pins, static_cast<int>(1 + rng() % 3) * scale);
+    }
+    return builder.build();
+}
+
+void scaledWeightsGiveSameResult(StorageMode mode) {
+    const int scale = 1 << 28;
+    Hypergraph light = randomGraph(mode, 1);
+    Hypergraph heavy = randomGraph(mode, scale);
+    check(heavy.maxWeightedDegree() == light.maxWeightedDegree() * scale, "weighted degree scales");
+
+    Partitioner a(light, AreaDef::Area, 650);
+    Partitioner b(heavy, AreaDef::Area, 650);
+    const PartitionResult& ra = a.run();
+    const PartitionResult& rb = b.run();
+    check(ra.feasible && rb.feasible, "feasible");
+    check(ra.side == rb.side, "same partition");
+    check(ra.passes == rb.passes, "same number of passes");
+    check(rb.cutSize == ra.cutSize * scale, "cut scales");
+}
+
+void degreeAboveIntMax() {
+    // Node 0 sits on three INT_MAX nets, so its gain does not fit in an int
+    HypergraphBuilder builder;
+    for (int v = 0; v < 3; v++) {
+        builder.addNode();
+    }
+    builder.addNet({0, 1}, INT_MAX);
+    builder.addNet({0, 2}, INT_MAX);
+    builder.addNet({0, 1, 2}, INT_MAX);
+    Hypergraph graph = builder.build();
+    check(graph.maxWeightedDegree() == 3LL * INT_MAX, "degree summed in 64 bits");
+
+    Partitioner partitioner(graph, AreaDef::Num, 2);
+    const PartitionResult& result = partitioner.run();
+    check(result.feasible, "feasible");
+    check(result.cutSize == 2LL * INT_MAX, "best cut found");
+}
+
+}  // namespace
+
+int main() {
+    scaledWeightsGiveSameResult(StorageMode::Csr);
+    scaledWeightsGiveSameResult(StorageMode::Compressed);
+    degreeAboveIntMax();
+    if (failures == 0) {
+        std::cout << "all passed" << std::endl;
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}